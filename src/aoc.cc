@@ -0,0 +1,55 @@
+// All days in one binary, dispatched through the compile-time registry:
+//   aoc [DAY...] [memory flags, see MemoryBudget]
+// Without days every registered day is solved in order. Peak RSS is for the
+// whole process, so it only grows from one day to the next.
+#include <charconv>
+
+#define AOC_RUNNER
+#include "day01.cc"
+#include "day02.cc"
+#include "day03.cc"
+#include "day04.cc"
+#include "day05.cc"
+#include "day06.cc"
+
+using Days = DayRegistry<day01::Solution, day02::Solution, day03::Solution,
+                         day04::Solution, day05::Solution, day06::Solution>;
+
+int main(int argc, char **argv) {
+  MemoryBudget budget;
+  std::vector<int> days;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      if (parse_memory_flag(argc, argv, i, budget)) {
+        continue;
+      }
+      const std::string arg = argv[i];
+      int day = 0;
+      const auto [end, error] =
+          std::from_chars(arg.data(), arg.data() + arg.size(), day);
+      if (arg.empty() || error != std::errc() ||
+          end != arg.data() + arg.size()) {
+        throw std::runtime_error("Unknown flag " + arg);
+      }
+      days.push_back(day);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return kUsageError;
+  }
+  bool within_budget = true;
+  const auto run = [&budget, &within_budget]<Solver S>() {
+    std::cout << "Day " << S::day << std::endl;
+    within_budget = solve<S>(S::input_path, budget) && within_budget;
+  };
+  if (days.empty()) {
+    Days::for_each(run);
+  }
+  for (const int day : days) {
+    if (!Days::dispatch(day, run)) {
+      std::cerr << "No solver for day " << day << std::endl;
+      return 1;
+    }
+  }
+  return within_budget ? 0 : 1;
+}
@@ -0,0 +1,334 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "util.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Keeps the compiler from discarding a computed value.
+template <typename T> void do_not_optimize(const T &value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Hardware counters for the calling thread. Counters the kernel refuses to
+// open (no PMU, perf_event_paranoid, containers) read as unavailable.
+class PerfCounters {
+public:
+  static constexpr int kNumCounters = 4;
+
+  PerfCounters() {
+    fds_.fill(-1);
+#ifdef __linux__
+    const std::array<std::uint64_t, kNumCounters> configs = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < kNumCounters; ++i) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fds_[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+  }
+
+  ~PerfCounters() {
+#ifdef __linux__
+    for (const int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  void start() {
+#ifdef __linux__
+    for (const int fd : fds_) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  // Counts since start(); -1 for counters that are unavailable.
+  std::array<double, kNumCounters> stop() {
+    std::array<double, kNumCounters> counts;
+    counts.fill(-1);
+#ifdef __linux__
+    for (int i = 0; i < kNumCounters; ++i) {
+      if (fds_[i] < 0) {
+        continue;
+      }
+      ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+      std::uint64_t value = 0;
+      if (read(fds_[i], &value, sizeof(value)) == sizeof(value)) {
+        counts[i] = static_cast<double>(value);
+      }
+    }
+#endif
+    return counts;
+  }
+
+private:
+  std::array<int, kNumCounters> fds_;
+};
+
+struct BenchResult {
+  std::string name;
+  double ns_per_op;
+  double stddev;
+  int samples;
+  double bytes_per_second;
+  // Hardware counters per op, negative when unavailable.
+  double cycles_per_op;
+  double instructions_per_op;
+  double cache_misses_per_op;
+  double branch_misses_per_op;
+};
+
+void write_bench_json(const std::string &path,
+                      const std::vector<BenchResult> &results) {
+  std::ofstream out(path);
+  out << std::setprecision(10) << "{\n  \"benchmarks\": [\n";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const auto &r = results[i];
+    out << "    {\"name\": \"" << r.name << "\", \"ns_per_op\": " << r.ns_per_op
+        << ", \"stddev\": " << r.stddev << ", \"samples\": " << r.samples
+        << ", \"bytes_per_second\": " << r.bytes_per_second
+        << ", \"cycles_per_op\": " << r.cycles_per_op
+        << ", \"instructions_per_op\": " << r.instructions_per_op
+        << ", \"cache_misses_per_op\": " << r.cache_misses_per_op
+        << ", \"branch_misses_per_op\": " << r.branch_misses_per_op << "}"
+        << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n}\n";
+}
+
+double json_number(const std::string &line, const std::string &key) {
+  const auto pos = line.find("\"" + key + "\": ");
+  if (pos == std::string::npos) {
+    throw std::runtime_error("Missing " + key + " in " + line);
+  }
+  return std::stod(line.substr(pos + key.size() + 4));
+}
+
+// Reads files written by write_bench_json, one benchmark object per line.
+std::map<std::string, BenchResult>
+read_bench_json(const std::string &path) {
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error("Cannot open baseline " + path);
+  }
+  std::map<std::string, BenchResult> results;
+  std::string line;
+  while (std::getline(in, line)) {
+    const auto name_pos = line.find("\"name\": \"");
+    if (name_pos == std::string::npos) {
+      continue;
+    }
+    const auto name_begin = name_pos + 9;
+    BenchResult r{};
+    r.name = line.substr(name_begin, line.find('"', name_begin) - name_begin);
+    r.ns_per_op = json_number(line, "ns_per_op");
+    r.stddev = json_number(line, "stddev");
+    r.samples = static_cast<int>(json_number(line, "samples"));
+    results[r.name] = r;
+  }
+  return results;
+}
+
+// A result is a regression when it is more than `min_slowdown` slower than the
+// baseline and Welch's t statistic exceeds `min_t`, i.e. the difference is
+// well outside the sample noise of both runs.
+bool is_regression(const BenchResult &baseline, const BenchResult &current,
+                   double min_slowdown = 0.10, double min_t = 3.0) {
+  if (current.ns_per_op <= baseline.ns_per_op * (1.0 + min_slowdown)) {
+    return false;
+  }
+  const double se = std::sqrt(
+      baseline.stddev * baseline.stddev / std::max(baseline.samples, 1) +
+      current.stddev * current.stddev / std::max(current.samples, 1));
+  if (se == 0.0) {
+    return true;
+  }
+  return (current.ns_per_op - baseline.ns_per_op) / se > min_t;
+}
+
+// Per-kernel microbenchmarks. Usage:
+//   dayNN --bench [--filter SUBSTR] [--save FILE] [--compare FILE]
+//                 [--threshold FRACTION]
+class BenchSuite {
+public:
+  // Registers `fn`, which performs `ops` kernel calls over `bytes` bytes of
+  // input each time it is invoked.
+  void add(const std::string &name, std::size_t ops, std::size_t bytes,
+           std::function<void()> fn) {
+    benchmarks_.push_back(
+        Benchmark{.name = name, .ops = ops, .bytes = bytes, .fn = fn});
+  }
+
+  int main(int argc, char **argv) {
+    std::string filter;
+    std::string save_path;
+    std::string compare_path;
+    double threshold = 0.10;
+    for (int i = 2; i < argc; ++i) {
+      const std::string flag = argv[i];
+      if (flag == "--filter") {
+        filter = flag_value(argc, argv, i);
+      } else if (flag == "--save") {
+        save_path = flag_value(argc, argv, i);
+      } else if (flag == "--compare") {
+        compare_path = flag_value(argc, argv, i);
+      } else if (flag == "--threshold") {
+        threshold = std::stod(flag_value(argc, argv, i));
+      } else {
+        throw std::runtime_error("Unknown flag " + flag);
+      }
+    }
+
+    std::vector<BenchResult> results;
+    std::cout << std::left << std::setw(32) << "benchmark" << std::right
+              << std::setw(12) << "ns/op" << std::setw(12) << "MB/s"
+              << std::setw(12) << "cycles" << std::setw(12) << "instrs"
+              << std::setw(12) << "cache-miss" << std::setw(12) << "br-miss"
+              << std::endl;
+    for (const auto &benchmark : benchmarks_) {
+      if (benchmark.name.find(filter) == std::string::npos) {
+        continue;
+      }
+      results.push_back(run(benchmark));
+      print(results.back());
+    }
+    if (!save_path.empty()) {
+      write_bench_json(save_path, results);
+    }
+    if (compare_path.empty()) {
+      return 0;
+    }
+    const auto baseline = read_bench_json(compare_path);
+    int regressions = 0;
+    for (const auto &result : results) {
+      const auto it = baseline.find(result.name);
+      if (it == baseline.end()) {
+        continue;
+      }
+      if (is_regression(it->second, result, threshold)) {
+        std::cout << "REGRESSION " << result.name << ": " << std::fixed
+                  << std::setprecision(2) << it->second.ns_per_op << " -> "
+                  << result.ns_per_op << " ns/op" << std::defaultfloat
+                  << std::endl;
+        ++regressions;
+      }
+    }
+    return regressions == 0 ? 0 : 1;
+  }
+
+private:
+  struct Benchmark {
+    std::string name;
+    std::size_t ops;
+    std::size_t bytes;
+    std::function<void()> fn;
+  };
+
+  static constexpr int kSamples = 15;
+  static constexpr double kMinSampleSeconds = 0.01;
+
+  static double time_calls(const Benchmark &benchmark, int calls) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) {
+      benchmark.fn();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+  }
+
+  BenchResult run(const Benchmark &benchmark) {
+    int calls = 1;
+    while (time_calls(benchmark, calls) < kMinSampleSeconds) {
+      calls *= 2;
+    }
+    const double ops_per_sample = static_cast<double>(calls) * benchmark.ops;
+    std::vector<double> ns_per_op;
+    double total_seconds = 0.0;
+    counters_.start();
+    for (int i = 0; i < kSamples; ++i) {
+      const double seconds = time_calls(benchmark, calls);
+      total_seconds += seconds;
+      ns_per_op.push_back(seconds * 1e9 / ops_per_sample);
+    }
+    const auto counts = counters_.stop();
+
+    const double mean = sum(ns_per_op) / kSamples;
+    double variance = 0.0;
+    for (const double x : ns_per_op) {
+      variance += (x - mean) * (x - mean);
+    }
+    variance /= kSamples - 1;
+    const double total_ops = ops_per_sample * kSamples;
+    const auto per_op = [total_ops](double count) {
+      return count < 0 ? -1.0 : count / total_ops;
+    };
+    return BenchResult{
+        .name = benchmark.name,
+        .ns_per_op = mean,
+        .stddev = std::sqrt(variance),
+        .samples = kSamples,
+        .bytes_per_second = static_cast<double>(calls) * kSamples *
+                            benchmark.bytes / total_seconds,
+        .cycles_per_op = per_op(counts[0]),
+        .instructions_per_op = per_op(counts[1]),
+        .cache_misses_per_op = per_op(counts[2]),
+        .branch_misses_per_op = per_op(counts[3])};
+  }
+
+  static void print(const BenchResult &r) {
+    const auto counter = [](double value) {
+      std::ostringstream s;
+      if (value < 0) {
+        s << "n/a";
+      } else {
+        s << std::fixed << std::setprecision(2) << value;
+      }
+      return s.str();
+    };
+    std::cout << std::left << std::setw(32) << r.name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(12)
+              << r.ns_per_op << std::setw(12) << r.bytes_per_second / 1e6
+              << std::setw(12) << counter(r.cycles_per_op) << std::setw(12)
+              << counter(r.instructions_per_op) << std::setw(12)
+              << counter(r.cache_misses_per_op) << std::setw(12)
+              << counter(r.branch_misses_per_op) << std::defaultfloat
+              << std::endl;
+  }
+
+  std::vector<Benchmark> benchmarks_;
+  PerfCounters counters_;
+};
@@ -0,0 +1,122 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "util.h"
+
+// Self-checks for `dayNN --check [--budget-scale FACTOR]`:
+//  - golden answers for the example and puzzle inputs, each of which must also
+//    finish within a time budget of a few times its measured solve time
+//    (scaled by FACTOR, e.g. for sanitizer builds or a loaded machine). An
+//    answer over budget is re-timed and fails only if none of kBudgetAttempts
+//    runs fits, so a cold cache or one descheduled run does not fail it,
+//  - differential tests of the solver kernels against simple reference
+//    implementations on randomly generated inputs.
+class CheckSuite {
+public:
+  void expect_answer(const std::string &name, long expected,
+                     std::function<long()> solve, double budget_seconds) {
+    answers_.push_back(Answer{.name = name,
+                              .expected = expected,
+                              .solve = solve,
+                              .budget_seconds = budget_seconds});
+  }
+
+  // `property` gets a seeded generator and returns false on a mismatch.
+  void add_differential(const std::string &name, int trials,
+                        std::function<bool(std::mt19937 &)> property) {
+    differentials_.push_back(
+        Differential{.name = name, .trials = trials, .property = property});
+  }
+
+  int main(int argc, char **argv) {
+    double budget_scale = 1.0;
+    for (int i = 2; i < argc; ++i) {
+      const std::string flag = argv[i];
+      if (flag == "--budget-scale") {
+        budget_scale = std::stod(flag_value(argc, argv, i));
+      } else {
+        throw std::runtime_error("Unknown flag " + flag);
+      }
+    }
+
+    int failures = 0;
+    for (const auto &answer : answers_) {
+      // The solvers print diagnostics; keep them out of the report.
+      std::ostringstream discarded;
+      auto *const cout_buffer = std::cout.rdbuf(discarded.rdbuf());
+      const double budget = answer.budget_seconds * budget_scale;
+      long result = 0;
+      double seconds = std::numeric_limits<double>::infinity();
+      for (int attempt = 0; attempt < kBudgetAttempts; ++attempt) {
+        const auto start = std::chrono::steady_clock::now();
+        result = answer.solve();
+        const auto stop = std::chrono::steady_clock::now();
+        seconds = std::min(
+            seconds, std::chrono::duration<double>(stop - start).count());
+        if (result != answer.expected || seconds <= budget) {
+          break;
+        }
+      }
+      std::cout.rdbuf(cout_buffer);
+
+      if (result != answer.expected) {
+        std::cout << "FAIL " << answer.name << ": got " << result
+                  << ", expected " << answer.expected << std::endl;
+        ++failures;
+      } else if (seconds > budget) {
+        std::cout << "FAIL " << answer.name << ": took " << seconds
+                  << "s, budget " << budget << "s" << std::endl;
+        ++failures;
+      } else {
+        std::cout << "ok   " << answer.name << " (" << seconds << "s)"
+                  << std::endl;
+      }
+    }
+
+    for (const auto &differential : differentials_) {
+      int trial = 0;
+      for (; trial < differential.trials; ++trial) {
+        std::mt19937 rng(trial);
+        if (!differential.property(rng)) {
+          break;
+        }
+      }
+      if (trial < differential.trials) {
+        std::cout << "FAIL " << differential.name << ": mismatch with seed "
+                  << trial << std::endl;
+        ++failures;
+      } else {
+        std::cout << "ok   " << differential.name << " (" << trial
+                  << " trials)" << std::endl;
+      }
+    }
+    return failures == 0 ? 0 : 1;
+  }
+
+private:
+  static constexpr int kBudgetAttempts = 3;
+
+  struct Answer {
+    std::string name;
+    long expected;
+    std::function<long()> solve;
+    double budget_seconds;
+  };
+
+  struct Differential {
+    std::string name;
+    int trials;
+    std::function<bool(std::mt19937 &)> property;
+  };
+
+  std::vector<Answer> answers_;
+  std::vector<Differential> differentials_;
+};
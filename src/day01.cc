@@ -3,12 +3,18 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <random>
 #include <string>
 #include <tuple>
 #include <vector>
 
+#include "bench.h"
+#include "check.h"
+#include "solver.h"
 #include "util.h"
 
+namespace day01 {
+
 std::vector<int> numbers(std::string line) {
   std::vector<char> num_chars;
   std::copy_if(std::begin(line), std::end(line), std::back_inserter(num_chars),
@@ -40,9 +46,11 @@ std::vector<int> numbers_extended(std::string line) {
   return numbers;
 }
 
-int compute_calibration_number(
-    const std::vector<std::string> &input,
-    std::function<std::vector<int>(std::string)> get_numbers) {
+// `get_numbers` is a distinct lambda per part, so each part gets its own
+// instantiation with the extractor inlined into the loop.
+template <typename GetNumbers>
+int compute_calibration_number(const std::vector<std::string> &input,
+                               GetNumbers get_numbers) {
   int total = 0;
   for (const auto &line : input) {
     const auto nums = get_numbers(line);
@@ -55,18 +63,87 @@ int compute_calibration_number(
 
 int part1(const std::vector<std::string> &input) {
   return compute_calibration_number(
-      input, [](std::string line) { return numbers(line); });
+      input, [](const std::string &line) { return numbers(line); });
 }
 
 int part2(const std::vector<std::string> &input) {
   return compute_calibration_number(
-      input, [](std::string line) { return numbers_extended(line); });
+      input, [](const std::string &line) { return numbers_extended(line); });
+}
+
+void add_benchmarks(BenchSuite &suite) {
+  std::mt19937 rng(1);
+  const std::vector<std::string> words{"one", "two",   "three", "four", "five",
+                                       "six", "seven", "eight", "nine"};
+  std::vector<std::string> lines(1000);
+  std::size_t bytes = 0;
+  for (auto &line : lines) {
+    while (line.size() < 50) {
+      const int kind = rng() % 4;
+      if (kind == 0) {
+        line += static_cast<char>('1' + rng() % 9);
+      } else if (kind == 1) {
+        line += words[rng() % words.size()];
+      } else {
+        line += static_cast<char>('a' + rng() % 26);
+      }
+    }
+    bytes += line.size();
+  }
+  suite.add("numbers", lines.size(), bytes, [lines] {
+    for (const auto &line : lines) {
+      do_not_optimize(numbers(line));
+    }
+  });
+  suite.add("numbers_extended", lines.size(), bytes, [lines] {
+    for (const auto &line : lines) {
+      do_not_optimize(numbers_extended(line));
+    }
+  });
 }
 
-int main() {
-  const auto input = read_input("inputs/day01.txt");
-  const int part1_result = part1(input);
-  std::cout << "Part 1: " << part1_result << std::endl;
-  const int part2_result = part2(input);
-  std::cout << "Part 2: " << part2_result << std::endl;
-}
\ No newline at end of file
+void add_checks(CheckSuite &suite) {
+  suite.expect_answer(
+      "part1 day01_test", 142,
+      [] { return part1(read_input("inputs/day01_test.txt")); }, 0.0005);
+  suite.expect_answer(
+      "part2 day01_test_2", 281,
+      [] { return part2(read_input("inputs/day01_test_2.txt")); }, 0.0005);
+  suite.expect_answer(
+      "part1 day01", 55386,
+      [] { return part1(read_input("inputs/day01.txt")); }, 0.002);
+  suite.expect_answer(
+      "part2 day01", 54824,
+      [] { return part2(read_input("inputs/day01.txt")); }, 0.01);
+  // Letters that occur in no number word, so both parsers must agree.
+  suite.add_differential("numbers_extended vs numbers", 1000, [](auto &rng) {
+    const std::string alphabet = "123456789abcdjklmpqyz";
+    std::string line;
+    for (int i = 0; i < 40; ++i) {
+      line += alphabet[rng() % alphabet.size()];
+    }
+    return numbers_extended(line) == numbers(line);
+  });
+}
+
+struct Solution {
+  static constexpr int day = 1;
+  static constexpr const char *input_path = "inputs/day01.txt";
+  using Model = std::vector<std::string>;
+
+  static Model parse(const std::vector<std::string> &input) { return input; }
+  static int part1(const Model &lines) { return day01::part1(lines); }
+  static int part2(const Model &lines) { return day01::part2(lines); }
+  static void add_benchmarks(BenchSuite &suite) {
+    day01::add_benchmarks(suite);
+  }
+  static void add_checks(CheckSuite &suite) { day01::add_checks(suite); }
+};
+
+} // namespace day01
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv) {
+  return run_day<day01::Solution>(argc, argv);
+}
+#endif
@@ -1,9 +1,16 @@
 #include <functional>
 #include <iostream>
 #include <numeric>
+#include <random>
+#include <ranges>
 
+#include "bench.h"
+#include "check.h"
+#include "solver.h"
 #include "util.h"
 
+namespace day02 {
+
 struct Set {
   int num_red;
   int num_green;
@@ -50,6 +57,13 @@ Game parse_game(std::string line) {
   return Game{.id = id, .sets = sets};
 }
 
+std::vector<Game> parse_games(const std::vector<std::string> &input) {
+  std::vector<Game> games;
+  std::transform(input.begin(), input.end(), std::back_insert_iterator(games),
+                 parse_game);
+  return games;
+}
+
 bool is_game_possible(const Game &game, const int max_red, const int max_green,
                       const int max_blue) {
   return std::all_of(game.sets.begin(), game.sets.end(),
@@ -61,15 +75,10 @@ bool is_game_possible(const Game &game, const int max_red, const int max_green,
 }
 
 int part1(const std::vector<Game> &games) {
-  std::vector<Game> possible_games;
-  std::copy_if(
-      games.begin(), games.end(), std::back_inserter(possible_games),
-      [](const auto &game) { return is_game_possible(game, 12, 13, 14); });
-  std::vector<int> possible_ids;
-  std::transform(possible_games.begin(), possible_games.end(),
-                 std::back_inserter(possible_ids),
-                 [](const auto &game) { return game.id; });
-  return std::accumulate(possible_ids.begin(), possible_ids.end(), 0);
+  return sum(games | std::views::filter([](const auto &game) {
+               return is_game_possible(game, 12, 13, 14);
+             }) |
+             std::views::transform(&Game::id));
 }
 
 Set minimum_possible(const Game &game) {
@@ -92,24 +101,116 @@ Set minimum_possible(const Game &game) {
 }
 
 int part2(const std::vector<Game> &games) {
-  std::vector<int> power;
-  std::transform(games.begin(), games.end(), std::back_inserter(power),
-                 [](const auto &game) {
-                   const auto min_possible = minimum_possible(game);
-                   return min_possible.num_red * min_possible.num_green *
-                          min_possible.num_blue;
-                 });
-  return std::accumulate(power.begin(), power.end(), 0);
+  return sum(games | std::views::transform([](const auto &game) {
+               const auto min_possible = minimum_possible(game);
+               return min_possible.num_red * min_possible.num_green *
+                      min_possible.num_blue;
+             }));
 }
 
-int main() {
-  const auto input = read_input("inputs/day02.txt");
-  std::vector<Game> games;
-  std::transform(input.begin(), input.end(), std::back_insert_iterator(games),
-                 parse_game);
-  const int result1 = part1(games);
-  const int result2 = part2(games);
+void add_benchmarks(BenchSuite &suite) {
+  std::mt19937 rng(2);
+  const std::vector<std::string> colors{"red", "green", "blue"};
+  const auto random_set = [&] {
+    std::string set;
+    for (int i = 0; i < 3; ++i) {
+      set += (i > 0 ? ", " : " ") + std::to_string(1 + rng() % 20) + " " +
+             colors[i];
+    }
+    return set;
+  };
+  std::vector<std::string> sets(1000);
+  std::size_t set_bytes = 0;
+  for (auto &set : sets) {
+    set = random_set();
+    set_bytes += set.size();
+  }
+  std::vector<std::string> games(1000);
+  std::size_t game_bytes = 0;
+  for (std::size_t i = 0; i < games.size(); ++i) {
+    games[i] = "Game " + std::to_string(i + 1) + ":";
+    for (int j = 0; j < 6; ++j) {
+      games[i] += (j > 0 ? ";" : "") + random_set();
+    }
+    game_bytes += games[i].size();
+  }
+  suite.add("parse_set", sets.size(), set_bytes, [sets] {
+    for (const auto &set : sets) {
+      do_not_optimize(parse_set(set));
+    }
+  });
+  suite.add("parse_game", games.size(), game_bytes, [games] {
+    for (const auto &game : games) {
+      do_not_optimize(parse_game(game));
+    }
+  });
+}
+
+void add_checks(CheckSuite &suite) {
+  suite.expect_answer(
+      "part1 day02_test", 8,
+      [] { return part1(parse_games(read_input("inputs/day02_test.txt"))); },
+      0.0005);
+  suite.expect_answer(
+      "part2 day02_test", 2286,
+      [] { return part2(parse_games(read_input("inputs/day02_test.txt"))); },
+      0.0005);
+  suite.expect_answer(
+      "part1 day02", 2528,
+      [] { return part1(parse_games(read_input("inputs/day02.txt"))); }, 0.004);
+  suite.expect_answer(
+      "part2 day02", 67363,
+      [] { return part2(parse_games(read_input("inputs/day02.txt"))); }, 0.004);
+  // Reference: explicit loops over printed-then-parsed random games.
+  suite.add_differential("part1/part2 vs reference", 200, [](auto &rng) {
+    std::vector<Game> games;
+    int expected1 = 0;
+    int expected2 = 0;
+    for (int id = 1; id <= 20; ++id) {
+      std::string line = "Game " + std::to_string(id) + ":";
+      Set max{.num_red = 0, .num_green = 0, .num_blue = 0};
+      const int num_sets = 1 + rng() % 5;
+      for (int i = 0; i < num_sets; ++i) {
+        const Set set{.num_red = static_cast<int>(rng() % 16),
+                      .num_green = static_cast<int>(rng() % 16),
+                      .num_blue = static_cast<int>(rng() % 16)};
+        line += (i > 0 ? "; " : " ") + std::to_string(set.num_red) +
+                " red, " + std::to_string(set.num_green) + " green, " +
+                std::to_string(set.num_blue) + " blue";
+        max.num_red = std::max(max.num_red, set.num_red);
+        max.num_green = std::max(max.num_green, set.num_green);
+        max.num_blue = std::max(max.num_blue, set.num_blue);
+      }
+      games.push_back(parse_game(line));
+      if (max.num_red <= 12 && max.num_green <= 13 && max.num_blue <= 14) {
+        expected1 += id;
+      }
+      expected2 += max.num_red * max.num_green * max.num_blue;
+    }
+    return part1(games) == expected1 && part2(games) == expected2;
+  });
+}
+
+struct Solution {
+  static constexpr int day = 2;
+  static constexpr const char *input_path = "inputs/day02.txt";
+  using Model = std::vector<Game>;
 
-  std::cout << "Part 1: " << result1 << std::endl;
-  std::cout << "Part 2: " << result2 << std::endl;
-}
\ No newline at end of file
+  static Model parse(const std::vector<std::string> &input) {
+    return parse_games(input);
+  }
+  static int part1(const Model &model) { return day02::part1(model); }
+  static int part2(const Model &model) { return day02::part2(model); }
+  static void add_benchmarks(BenchSuite &suite) {
+    day02::add_benchmarks(suite);
+  }
+  static void add_checks(CheckSuite &suite) { day02::add_checks(suite); }
+};
+
+} // namespace day02
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv) {
+  return run_day<day02::Solution>(argc, argv);
+}
+#endif
@@ -1,14 +1,22 @@
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <numeric>
+#include <random>
+#include <ranges>
 #include <string>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "bench.h"
+#include "check.h"
+#include "solver.h"
 #include "util.h"
 
+namespace day03 {
+
 struct Coordinate {
   int row;
   int col;
@@ -16,15 +24,21 @@ struct Coordinate {
     return row == other.row && col == other.col;
   }
 };
-template <>
-struct std::hash<Coordinate> {
-  std::size_t operator()(const Coordinate &item) const {
-    const std::size_t h1 = std::hash<int>{}(item.row);
-    const std::size_t h2 = std::hash<int>{}(item.col);
-    return h1 ^ (h2 << 1);
+
+} // namespace day03
+
+template <> struct std::hash<day03::Coordinate> {
+  std::size_t operator()(const day03::Coordinate &item) const {
+    const std::uint64_t packed =
+        (static_cast<std::uint64_t>(static_cast<std::uint32_t>(item.row))
+         << 32) |
+        static_cast<std::uint32_t>(item.col);
+    return mix_hash(packed);
   }
 };
 
+namespace day03 {
+
 struct PositionedNumber {
   int number;
   Coordinate position;
@@ -32,15 +46,18 @@ struct PositionedNumber {
     return number == other.number && position == other.position;
   }
 };
-template <>
-struct std::hash<PositionedNumber> {
-  std::size_t operator()(const PositionedNumber &item) const {
-    const std::size_t h1 = std::hash<int>{}(item.number);
-    const std::size_t h2 = std::hash<Coordinate>{}(item.position);
-    return h1 ^ (h2 << 1);
+
+} // namespace day03
+
+template <> struct std::hash<day03::PositionedNumber> {
+  std::size_t operator()(const day03::PositionedNumber &item) const {
+    const std::size_t h = std::hash<day03::Coordinate>{}(item.position);
+    return mix_hash(h ^ static_cast<std::uint32_t>(item.number));
   }
 };
 
+namespace day03 {
+
 std::vector<Coordinate> neighboring_part(const std::vector<std::string> &lines,
                                          int row, int col) {
   const std::vector<std::tuple<int, int>> coords = {
@@ -50,8 +67,7 @@ std::vector<Coordinate> neighboring_part(const std::vector<std::string> &lines,
 
   std::vector<Coordinate> neighbors;
   for (const auto &[nr, nc] : coords) {
-    if (nr < 0 || nc < 0 || (nr >= lines.size() - 1) ||
-        (nc >= lines[0].size() - 1)) {
+    if (nr < 0 || nc < 0 || nr >= lines.size() || nc >= lines[nr].size()) {
       continue;
     }
     const char c = lines[nr][nc];
@@ -62,12 +78,29 @@ std::vector<Coordinate> neighboring_part(const std::vector<std::string> &lines,
   return neighbors;
 }
 
-std::unordered_map<PositionedNumber, std::vector<Coordinate>> find_numbers(
-    const std::vector<std::string> &lines) {
-  std::unordered_map<PositionedNumber, std::vector<Coordinate>> numbers;
+using Neighbors = SmallVector<Coordinate, 4>;
+
+FlatHashMap<PositionedNumber, Neighbors>
+find_numbers(const std::vector<std::string> &lines) {
+  FlatHashMap<PositionedNumber, Neighbors> numbers;
   std::string current_number;
   std::unordered_set<Coordinate> current_neighbors;
   Coordinate current_coords;
+  const auto flush_number = [&] {
+    if (current_number.empty()) {
+      return;
+    }
+    const int num = std::atoi(current_number.c_str());
+    Neighbors neighbors;
+    for (const auto &neighbor : current_neighbors) {
+      neighbors.push_back(neighbor);
+    }
+    const PositionedNumber pn{.number = num, .position = current_coords};
+    numbers[pn] = neighbors;
+
+    current_number.clear();
+    current_neighbors.clear();
+  };
   for (int row = 0; row < lines.size(); ++row) {
     for (int col = 0; col < lines[row].size(); ++col) {
       const char c = lines[row][col];
@@ -81,44 +114,37 @@ std::unordered_map<PositionedNumber, std::vector<Coordinate>> find_numbers(
           current_neighbors.insert(neighbor);
         }
       } else {
-        if (current_number.size() > 0) {
-          const int num = std::atoi(current_number.c_str());
-          std::vector<Coordinate> neighbors;
-          neighbors.insert(neighbors.end(), current_neighbors.begin(),
-                           current_neighbors.end());
-          const PositionedNumber pn{.number = num, .position = current_coords};
-          numbers[pn] = neighbors;
-
-          current_number.clear();
-          current_neighbors.clear();
-        }
+        flush_number();
       }
     }
+    // Numbers end at the end of a row.
+    flush_number();
   }
   return numbers;
 }
 
-int part1(const std::vector<std::string> &lines) {
-  const auto numbers = find_numbers(lines);
-  std::vector<int> part_numbers;
-  std::transform(numbers.begin(), numbers.end(),
-                 std::back_inserter(part_numbers), [](const auto &item) {
-                   const auto &[key, value] = item;
-                   const auto &[number, _] = key;
-                   if (value.empty()) {
-                     return 0;
-                   }
-                   return number;
-                 });
-  return std::accumulate(part_numbers.begin(), part_numbers.end(), 0);
+struct Schematic {
+  std::vector<std::string> lines;
+  FlatHashMap<PositionedNumber, Neighbors> numbers;
+};
+
+Schematic parse_schematic(const std::vector<std::string> &lines) {
+  return Schematic{.lines = lines, .numbers = find_numbers(lines)};
+}
+
+int part1(const Schematic &schematic) {
+  return sum(schematic.numbers | std::views::filter([](const auto &item) {
+               return !item.second.empty();
+             }) |
+             std::views::transform(
+                 [](const auto &item) { return item.first.number; }));
 }
 
-int part2(const std::vector<std::string> &lines) {
-  const auto numbers = find_numbers(lines);
-  std::unordered_map<Coordinate, std::vector<int>> gear_to_number;
-  for (const auto &[pos_number, neighbors] : numbers) {
+int part2(const Schematic &schematic) {
+  FlatHashMap<Coordinate, SmallVector<int, 2>> gear_to_number;
+  for (const auto &[pos_number, neighbors] : schematic.numbers) {
     for (const auto &neighbor : neighbors) {
-      if (lines[neighbor.row][neighbor.col] == '*') {
+      if (schematic.lines[neighbor.row][neighbor.col] == '*') {
         gear_to_number[neighbor].push_back(pos_number.number);
       }
     }
@@ -132,11 +158,174 @@ int part2(const std::vector<std::string> &lines) {
   return std::accumulate(gear_ratios.begin(), gear_ratios.end(), 0);
 }
 
-int main() {
-  const auto input = read_input("inputs/day03.txt");
-  const int result1 = part1(input);
-  const int result2 = part2(input);
-  std::cout << "Part 1: " << result1 << std::endl;
-  std::cout << "Part 2: " << result2 << std::endl;
-  return 0;
-}
\ No newline at end of file
+void add_benchmarks(BenchSuite &suite) {
+  std::mt19937 rng(3);
+  const int size = 1000;
+  std::vector<std::string> grid(size, std::string(size, '.'));
+  std::size_t digits = 0;
+  for (auto &row : grid) {
+    for (auto &c : row) {
+      const int r = rng() % 10;
+      if (r < 3) {
+        c = static_cast<char>('0' + rng() % 10);
+        ++digits;
+      } else if (r == 3) {
+        c = "*#+$"[rng() % 4];
+      }
+    }
+  }
+  const std::size_t grid_bytes = size * size;
+  suite.add("neighboring_part", digits, grid_bytes, [grid] {
+    for (std::size_t row = 0; row < grid.size(); ++row) {
+      for (std::size_t col = 0; col < grid[row].size(); ++col) {
+        if (std::isdigit(grid[row][col])) {
+          do_not_optimize(neighboring_part(grid, row, col));
+        }
+      }
+    }
+  });
+  suite.add("find_numbers", 1, grid_bytes,
+            [grid] { do_not_optimize(find_numbers(grid)); });
+
+  // Coordinate-keyed counting on a large grid, flat map vs std container.
+  std::vector<Coordinate> keys(1 << 20);
+  for (auto &key : keys) {
+    key = Coordinate{.row = static_cast<int>(rng() % 2000),
+                     .col = static_cast<int>(rng() % 2000)};
+  }
+  const std::size_t key_bytes = keys.size() * sizeof(Coordinate);
+  suite.add("coordinate_count_flat_map", keys.size(), key_bytes, [keys] {
+    FlatHashMap<Coordinate, int> counts;
+    for (const auto &key : keys) {
+      counts[key] += 1;
+    }
+    do_not_optimize(counts);
+  });
+  suite.add("coordinate_count_unordered_map", keys.size(), key_bytes, [keys] {
+    std::unordered_map<Coordinate, int> counts;
+    for (const auto &key : keys) {
+      counts[key] += 1;
+    }
+    do_not_optimize(counts);
+  });
+}
+
+// Brute-force part 1 and part 2.
+std::tuple<int, int> reference_solution(const std::vector<std::string> &lines) {
+  std::map<std::tuple<int, int>, std::vector<int>> gears;
+  int part_sum = 0;
+  const int rows = lines.size();
+  for (int row = 0; row < rows; ++row) {
+    const int cols = lines[row].size();
+    for (int col = 0; col < cols; ++col) {
+      if (!std::isdigit(lines[row][col]) ||
+          (col > 0 && std::isdigit(lines[row][col - 1]))) {
+        continue;
+      }
+      int end = col;
+      while (end < cols && std::isdigit(lines[row][end])) {
+        ++end;
+      }
+      const int number = std::stoi(lines[row].substr(col, end - col));
+      bool is_part = false;
+      for (int r = std::max(row - 1, 0);
+           r <= std::min(row + 1, rows - 1); ++r) {
+        for (int c = std::max(col - 1, 0);
+             c <= std::min<int>(end, lines[r].size() - 1); ++c) {
+          const char s = lines[r][c];
+          if (!std::isdigit(s) && s != '.') {
+            is_part = true;
+            if (s == '*') {
+              gears[{r, c}].push_back(number);
+            }
+          }
+        }
+      }
+      if (is_part) {
+        part_sum += number;
+      }
+    }
+  }
+  int gear_sum = 0;
+  for (const auto &[_, nums] : gears) {
+    if (nums.size() == 2) {
+      gear_sum += nums[0] * nums[1];
+    }
+  }
+  return {part_sum, gear_sum};
+}
+
+void add_checks(CheckSuite &suite) {
+  suite.expect_answer(
+      "part1 day03_test", 4361,
+      [] {
+        return part1(parse_schematic(read_input("inputs/day03_test.txt")));
+      },
+      0.0005);
+  suite.expect_answer(
+      "part2 day03_test", 467835,
+      [] {
+        return part2(parse_schematic(read_input("inputs/day03_test.txt")));
+      },
+      0.0005);
+  suite.expect_answer(
+      "part1 day03", 528799,
+      [] { return part1(parse_schematic(read_input("inputs/day03.txt"))); },
+      0.004);
+  suite.expect_answer(
+      "part2 day03", 84907174,
+      [] { return part2(parse_schematic(read_input("inputs/day03.txt"))); },
+      0.004);
+  // A symbol in the last row or column, and numbers at the end of a row.
+  suite.expect_answer(
+      "part1 symbol in last row", 1,
+      [] { return part1(parse_schematic({"1*", ".."})); }, 0.0001);
+  suite.expect_answer(
+      "part1 number at end of row", 46,
+      [] { return part1(parse_schematic({".*12", "34..", "...."})); }, 0.0001);
+  suite.add_differential("part1/part2 vs brute force", 1000, [](auto &rng) {
+    const int rows = 1 + rng() % 20;
+    const int cols = 1 + rng() % 20;
+    std::vector<std::string> grid(rows, std::string(cols, '.'));
+    for (int row = 0; row < rows; ++row) {
+      for (int col = 0; col < cols; ++col) {
+        const int r = rng() % 10;
+        const bool long_number = col >= 3 && std::isdigit(grid[row][col - 1]) &&
+                                 std::isdigit(grid[row][col - 2]) &&
+                                 std::isdigit(grid[row][col - 3]);
+        if (r < 4 && !long_number) {
+          grid[row][col] = static_cast<char>('0' + rng() % 10);
+        } else if (r == 4) {
+          grid[row][col] = "**#+"[rng() % 4];
+        }
+      }
+    }
+    const auto [expected1, expected2] = reference_solution(grid);
+    const auto schematic = parse_schematic(grid);
+    return part1(schematic) == expected1 && part2(schematic) == expected2;
+  });
+}
+
+struct Solution {
+  static constexpr int day = 3;
+  static constexpr const char *input_path = "inputs/day03.txt";
+  using Model = Schematic;
+
+  static Model parse(const std::vector<std::string> &input) {
+    return parse_schematic(input);
+  }
+  static int part1(const Model &model) { return day03::part1(model); }
+  static int part2(const Model &model) { return day03::part2(model); }
+  static void add_benchmarks(BenchSuite &suite) {
+    day03::add_benchmarks(suite);
+  }
+  static void add_checks(CheckSuite &suite) { day03::add_checks(suite); }
+};
+
+} // namespace day03
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv) {
+  return run_day<day03::Solution>(argc, argv);
+}
+#endif
@@ -1,12 +1,20 @@
 #include <functional>
 #include <iostream>
+#include <map>
 #include <numeric>
+#include <random>
+#include <ranges>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "bench.h"
+#include "check.h"
+#include "solver.h"
 #include "util.h"
 
+namespace day04 {
+
 struct Card {
   int number;
   std::set<int> winning_numbers;
@@ -53,20 +61,19 @@ int compute_points(const Card &card) {
   return 1 << (match_count - 1);
 }
 
-int part1(const std::vector<std::string> &input) {
+std::vector<Card> parse_cards(const std::vector<std::string> &input) {
   std::vector<Card> cards;
-  std::transform(input.begin(), input.end(), std::back_inserter(cards),
+  std::transform(input.begin(), input.end(), std::back_insert_iterator(cards),
                  parse_card);
-  std::vector<int> points;
-  std::transform(cards.begin(), cards.end(), std::back_inserter(points),
-                 compute_points);
-  return std::accumulate(points.begin(), points.end(), 0);
+  return cards;
 }
 
-int part2(const std::vector<std::string> &input) {
-  std::vector<Card> cards;
-  std::transform(input.begin(), input.end(), std::back_insert_iterator(cards),
-                 parse_card);
+int part1(const std::vector<Card> &cards) {
+  return sum(cards | std::views::transform(compute_points));
+}
+
+int part2(const std::vector<Card> &original_cards) {
+  std::vector<Card> cards = original_cards;
   for (int i = 0; i < cards.size(); ++i) {
     const auto &current_card = cards[i];
     const int match_count = compute_match_count(current_card);
@@ -78,22 +85,138 @@ int part2(const std::vector<std::string> &input) {
       cards.push_back(cards[j]);
     }
   }
-  std::map<int, int> card_counter;
+  FlatHashMap<int, int> card_counter;
   for (const auto &card : cards) {
     card_counter[card.number] += 1;
   }
   std::cout << "Card counts" << std::endl;
-  for (const auto &[card, count] : card_counter) {
-    std::cout << "Card " << card << ": " << count << std::endl;
+  for (std::size_t i = 0; i < original_cards.size(); ++i) {
+    const int card = cards[i].number;
+    std::cout << "Card " << card << ": " << card_counter[card] << std::endl;
   }
   return cards.size();
 }
 
-int main() {
-  const auto input = read_input("inputs/day04.txt");
-  const int result1 = part1(input);
-  const int result2 = part2(input);
-  std::cout << "Part 1: " << result1 << std::endl;
-  std::cout << "Part 2: " << result2 << std::endl;
-  return 0;
+void add_benchmarks(BenchSuite &suite) {
+  std::mt19937 rng(4);
+  std::vector<Card> cards(1000);
+  for (std::size_t i = 0; i < cards.size(); ++i) {
+    cards[i].number = static_cast<int>(i) + 1;
+    while (cards[i].winning_numbers.size() < 10) {
+      cards[i].winning_numbers.insert(1 + rng() % 99);
+    }
+    while (cards[i].selected_numbers.size() < 25) {
+      cards[i].selected_numbers.insert(1 + rng() % 99);
+    }
+  }
+  const std::size_t card_bytes = cards.size() * 35 * sizeof(int);
+  suite.add("compute_match_count", cards.size(), card_bytes, [cards] {
+    for (const auto &card : cards) {
+      do_not_optimize(compute_match_count(card));
+    }
+  });
+
+  // Card-number counting, flat map vs the node-based std::map.
+  std::vector<int> numbers(1 << 20);
+  for (auto &number : numbers) {
+    number = 1 + rng() % 200;
+  }
+  const std::size_t number_bytes = numbers.size() * sizeof(int);
+  suite.add("card_count_flat_map", numbers.size(), number_bytes, [numbers] {
+    FlatHashMap<int, int> counts;
+    for (const int number : numbers) {
+      counts[number] += 1;
+    }
+    do_not_optimize(counts);
+  });
+  suite.add("card_count_std_map", numbers.size(), number_bytes, [numbers] {
+    std::map<int, int> counts;
+    for (const int number : numbers) {
+      counts[number] += 1;
+    }
+    do_not_optimize(counts);
+  });
+}
+
+void add_checks(CheckSuite &suite) {
+  suite.expect_answer(
+      "part1 day04_test", 13,
+      [] { return part1(parse_cards(read_input("inputs/day04_test.txt"))); },
+      0.0005);
+  suite.expect_answer(
+      "part2 day04_test", 30,
+      [] { return part2(parse_cards(read_input("inputs/day04_test.txt"))); },
+      0.0005);
+  suite.expect_answer(
+      "part2 day04_test2", 30,
+      [] { return part2(parse_cards(read_input("inputs/day04_test2.txt"))); },
+      0.0005);
+  suite.expect_answer(
+      "part1 day04", 25571,
+      [] { return part1(parse_cards(read_input("inputs/day04.txt"))); }, 0.01);
+  // part2 on the puzzle input copies millions of cards and is not checked.
+  suite.add_differential("compute_match_count vs brute force", 1000,
+                         [](auto &rng) {
+                           Card card{.number = 1};
+                           std::vector<int> winning(10);
+                           std::vector<int> selected(25);
+                           for (auto &x : winning) {
+                             x = 1 + rng() % 99;
+                             card.winning_numbers.insert(x);
+                           }
+                           for (auto &x : selected) {
+                             x = 1 + rng() % 99;
+                             card.selected_numbers.insert(x);
+                           }
+                           const std::set<int> unique_winning(
+                               winning.begin(), winning.end());
+                           int expected = 0;
+                           for (const int x : unique_winning) {
+                             expected += std::find(selected.begin(),
+                                                   selected.end(),
+                                                   x) != selected.end();
+                           }
+                           return compute_match_count(card) == expected;
+                         });
+  suite.add_differential("FlatHashMap vs std::map", 100, [](auto &rng) {
+    FlatHashMap<int, int> flat;
+    std::map<int, int> reference;
+    for (int i = 0; i < 1000; ++i) {
+      const int key = rng() % 300;
+      flat[key] += i;
+      reference[key] += i;
+    }
+    if (flat.size() != reference.size()) {
+      return false;
+    }
+    return std::all_of(reference.begin(), reference.end(),
+                       [&flat](const auto &item) {
+                         const auto it = flat.find(item.first);
+                         return it != flat.end() && (*it).second == item.second;
+                       });
+  });
+}
+
+struct Solution {
+  static constexpr int day = 4;
+  static constexpr const char *input_path = "inputs/day04.txt";
+  using Model = std::vector<Card>;
+
+  static Model parse(const std::vector<std::string> &input) {
+    return parse_cards(input);
+  }
+  static int part1(const Model &model) { return day04::part1(model); }
+  static int part2(const Model &model) { return day04::part2(model); }
+  static void add_benchmarks(BenchSuite &suite) {
+    day04::add_benchmarks(suite);
+  }
+  static void add_checks(CheckSuite &suite) { day04::add_checks(suite); }
+};
+
+} // namespace day04
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv) {
+  return run_day<day04::Solution>(argc, argv);
 }
+#endif
@@ -1,12 +1,19 @@
 #include <algorithm>
 #include <iostream>
 #include <iterator>
+#include <random>
+#include <ranges>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "bench.h"
+#include "check.h"
+#include "solver.h"
 #include "util.h"
 
+namespace day05 {
+
 struct Range {
   unsigned long begin;
   unsigned long end;
@@ -53,7 +60,7 @@ std::vector<Range> map_range(const Map &map, const Range &range) {
         break;
       } else if (current_range.begin < map.source_start &&
                  current_range.end > map.source_start &&
-                 current_range.end < map.source_start + map.range_length) {
+                 current_range.end <= map.source_start + map.range_length) {
         // Split range and process later.
         unmapped_ranges.push_back(
             Range{.begin = current_range.begin, .end = map.source_start});
@@ -195,20 +202,15 @@ std::vector<Range> repeated_map_range(const Almanac &almanac,
   return ranges;
 }
 
-unsigned long part1(const std::vector<std::string> &input) {
-  const auto almanac = parse_almanac(input);
+unsigned long part1(const Almanac &almanac) {
   print_almanac(almanac);
-  std::vector<unsigned long> locations;
-  std::transform(almanac.seeds.begin(), almanac.seeds.end(),
-                 std::back_inserter(locations),
-                 [&almanac](const unsigned long &x) {
-                   return repeated_apply(almanac, x);
-                 });
-  return *std::min_element(locations.begin(), locations.end());
+  return min_of(almanac.seeds | std::views::transform(
+                                   [&almanac](const unsigned long &x) {
+                                     return repeated_apply(almanac, x);
+                                   }));
 }
 
-unsigned long part2(const std::vector<std::string> &input) {
-  const auto almanac = parse_almanac(input);
+unsigned long part2(const Almanac &almanac) {
   std::vector<Range> seed_ranges;
   for (int i = 0; i < almanac.seeds.size() / 2; ++i) {
     seed_ranges.push_back(
@@ -227,11 +229,109 @@ unsigned long part2(const std::vector<std::string> &input) {
   return min->begin;
 }
 
-int main() {
-  const auto input = read_input("inputs/day05.txt");
-  const int result1 = part1(input);
-  const int result2 = part2(input);
-  std::cout << "Part 1: " << result1 << std::endl;
-  std::cout << "Part 2: " << result2 << std::endl;
-  return 0;
+void add_benchmarks(BenchSuite &suite) {
+  std::mt19937_64 rng(5);
+  // Disjoint source ranges tiling [0, 40 * 1000000), shuffled like real input.
+  Map map;
+  for (unsigned long i = 0; i < 40; ++i) {
+    map.ranges.push_back(MapRange{.destination_start = rng() % 4000000000UL,
+                                  .source_start = i * 1000000,
+                                  .range_length = 1000000});
+  }
+  std::shuffle(map.ranges.begin(), map.ranges.end(), rng);
+  std::vector<unsigned long> sources(1000);
+  for (auto &source : sources) {
+    source = rng() % 50000000;
+  }
+  std::vector<Range> ranges(1000);
+  for (auto &range : ranges) {
+    range.begin = rng() % 50000000;
+    range.end = range.begin + 1 + rng() % 5000000;
+  }
+  suite.add("apply_map", sources.size(),
+            sources.size() * sizeof(unsigned long), [map, sources] {
+              for (const auto source : sources) {
+                do_not_optimize(apply_map(map, source));
+              }
+            });
+  suite.add("map_range", ranges.size(), ranges.size() * sizeof(Range),
+            [map, ranges] {
+              for (const auto &range : ranges) {
+                do_not_optimize(map_range(map, range));
+              }
+            });
+}
+
+void add_checks(CheckSuite &suite) {
+  suite.expect_answer(
+      "part1 day05_test", 35,
+      [] { return part1(parse_almanac(read_input("inputs/day05_test.txt"))); },
+      0.0005);
+  suite.expect_answer(
+      "part2 day05_test", 46,
+      [] { return part2(parse_almanac(read_input("inputs/day05_test.txt"))); },
+      0.0005);
+  suite.expect_answer(
+      "part1 day05", 403695602,
+      [] { return part1(parse_almanac(read_input("inputs/day05.txt"))); },
+      0.001);
+  suite.expect_answer(
+      "part2 day05", 219529182,
+      [] { return part2(parse_almanac(read_input("inputs/day05.txt"))); },
+      0.001);
+  // map_range must map a range to exactly the values apply_map gives for
+  // each of its elements.
+  suite.add_differential("map_range vs apply_map", 1000, [](auto &rng) {
+    Map map;
+    unsigned long start = rng() % 10;
+    const int num_ranges = 1 + rng() % 5;
+    for (int i = 0; i < num_ranges; ++i) {
+      const unsigned long length = 1 + rng() % 20;
+      map.ranges.push_back(MapRange{.destination_start = rng() % 200,
+                                    .source_start = start,
+                                    .range_length = length});
+      start += length + rng() % 10;
+    }
+    std::shuffle(map.ranges.begin(), map.ranges.end(), rng);
+    Range range{.begin = rng() % 150};
+    range.end = range.begin + 1 + rng() % 60;
+
+    std::vector<unsigned long> expected;
+    for (unsigned long x = range.begin; x < range.end; ++x) {
+      expected.push_back(apply_map(map, x));
+    }
+    std::vector<unsigned long> actual;
+    for (const auto &mapped : map_range(map, range)) {
+      for (unsigned long x = mapped.begin; x < mapped.end; ++x) {
+        actual.push_back(x);
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    return actual == expected;
+  });
+}
+
+struct Solution {
+  static constexpr int day = 5;
+  static constexpr const char *input_path = "inputs/day05.txt";
+  using Model = Almanac;
+
+  static Model parse(const std::vector<std::string> &input) {
+    return parse_almanac(input);
+  }
+  static unsigned long part1(const Model &model) { return day05::part1(model); }
+  static unsigned long part2(const Model &model) { return day05::part2(model); }
+  static void add_benchmarks(BenchSuite &suite) {
+    day05::add_benchmarks(suite);
+  }
+  static void add_checks(CheckSuite &suite) { day05::add_checks(suite); }
+};
+
+} // namespace day05
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv) {
+  return run_day<day05::Solution>(argc, argv);
 }
+#endif
@@ -3,12 +3,18 @@
 #include <iostream>
 #include <iterator>
 #include <numeric>
+#include <random>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "bench.h"
+#include "check.h"
+#include "solver.h"
 #include "util.h"
 
+namespace day06 {
+
 struct Race {
   unsigned long time;
   unsigned long distance;
@@ -23,13 +29,13 @@ std::vector<Race> parse_races(const std::vector<std::string> &input) {
       const auto parts = split(line, ':');
       const auto nums = split(parts[1], ' ');
       std::transform(nums.begin(), nums.end(), std::back_inserter(times),
-                     [](const auto &s) { return std::atoi(s.c_str()); });
+                     [](const auto &s) { return std::stoul(s); });
     } else if (line.find("Distance:") != std::string::npos &&
                distances.empty()) {
       const auto parts = split(line, ':');
       const auto nums = split(parts[1], ' ');
       std::transform(nums.begin(), nums.end(), std::back_inserter(distances),
-                     [](const auto &s) { return std::atoi(s.c_str()); });
+                     [](const auto &s) { return std::stoul(s); });
 
     } else {
       throw std::runtime_error("Unexpected line" + line);
@@ -50,9 +56,7 @@ std::vector<Race> parse_races(const std::vector<std::string> &input) {
 std::tuple<long double, long double>
 critical_velocity(const unsigned long time, const unsigned long distance) {
   const unsigned long arg = time * time - 4 * distance;
-  std::cout << "arg = " << arg << std::endl;
-  const long double root = std::sqrtl(arg);
-  std::cout << "root = " << root << std::endl;
+  const long double root = std::sqrt(static_cast<long double>(arg));
   const long double vm = 0.5 * (time - root);
   const long double vp = 0.5 * (time + root);
   return {std::max({vm + 1.e-6, 1.0L}), vp - 1.0e-6};
@@ -62,12 +66,14 @@ unsigned long count_ways_of_winning(const Race &race) {
   const auto [vm, vp] = critical_velocity(race.time, race.distance);
   const unsigned long uvm = std::ceil(vm);
   const unsigned long uvp = std::floor(vp);
-  std::cout << "vm = " << uvm << "\tvp = " << uvp << std::endl;
+  // A record of exactly t^2 / 4 can only be tied, never beaten.
+  if (uvp < uvm) {
+    return 0;
+  }
   return uvp - uvm + 1;
 }
 
-unsigned long part1(const std::vector<std::string> &input) {
-  const auto races = parse_races(input);
+unsigned long part1(const std::vector<Race> &races) {
   std::vector<unsigned long> win_counts;
   std::transform(races.begin(), races.end(), std::back_inserter(win_counts),
                  count_ways_of_winning);
@@ -75,13 +81,102 @@ unsigned long part1(const std::vector<std::string> &input) {
                          [](const auto &x, const auto &y) { return x * y; });
 }
 
-int main() {
-  const auto input = read_input("inputs/day06.txt");
-  const int result1 = part1(input);
-  // Part 2 is not working due to floating point inaccuracy.
-  const auto input2 = read_input("inputs/day06_2.txt");
-  const unsigned long result2 = part1(input2);
-  std::cout << "Part 1: " << result1 << std::endl;
-  std::cout << "Part 2: " << result2 << std::endl;
-  return 0;
+// Part 2 reads the table as one race, ignoring the spaces between numbers.
+unsigned long part2(const std::vector<Race> &races) {
+  std::string time;
+  std::string distance;
+  for (const auto &race : races) {
+    time += std::to_string(race.time);
+    distance += std::to_string(race.distance);
+  }
+  return count_ways_of_winning(
+      Race{.time = std::stoul(time), .distance = std::stoul(distance)});
+}
+
+void add_benchmarks(BenchSuite &suite) {
+  std::mt19937_64 rng(6);
+  std::vector<Race> races(1000);
+  for (auto &race : races) {
+    race.time = 10 + rng() % 100000000;
+    // Any record below the best possible distance t^2 / 4 is beatable.
+    race.distance = rng() % (race.time * race.time / 4);
+  }
+  suite.add("count_ways_of_winning", races.size(),
+            races.size() * sizeof(Race), [races] {
+              for (const auto &race : races) {
+                do_not_optimize(count_ways_of_winning(race));
+              }
+            });
+}
+
+void add_checks(CheckSuite &suite) {
+  suite.expect_answer(
+      "part1 day06_test", 288,
+      [] { return part1(parse_races(read_input("inputs/day06_test.txt"))); },
+      0.0005);
+  suite.expect_answer(
+      "part2 day06_test", 71503,
+      [] { return part2(parse_races(read_input("inputs/day06_test.txt"))); },
+      0.0005);
+  suite.expect_answer(
+      "part1 day06_test2", 71503,
+      [] { return part1(parse_races(read_input("inputs/day06_test2.txt"))); },
+      0.0005);
+  suite.expect_answer(
+      "part1 day06", 2756160,
+      [] { return part1(parse_races(read_input("inputs/day06.txt"))); },
+      0.0001);
+  suite.expect_answer(
+      "part2 day06", 34788142,
+      [] { return part2(parse_races(read_input("inputs/day06.txt"))); },
+      0.0001);
+  suite.expect_answer(
+      "part1 day06_2", 34788142,
+      [] { return part1(parse_races(read_input("inputs/day06_2.txt"))); },
+      0.0001);
+  // The best possible distance is t^2 / 4; holding exactly that record can
+  // only be tied.
+  suite.expect_answer(
+      "count_ways_of_winning tied record", 0,
+      [] { return count_ways_of_winning(Race{.time = 2, .distance = 1}); },
+      0.0001);
+  // Every fourth race holds the best possible record, so the tied boundary
+  // is covered for odd and even times.
+  suite.add_differential("count_ways_of_winning vs brute force", 1000,
+                         [](auto &rng) {
+                           Race race{.time = 1 + rng() % 1000};
+                           const unsigned long best =
+                               race.time * race.time / 4;
+                           race.distance =
+                               rng() % 4 == 0 ? best : rng() % (best + 1);
+                           unsigned long expected = 0;
+                           for (unsigned long v = 0; v <= race.time; ++v) {
+                             expected += v * (race.time - v) > race.distance;
+                           }
+                           return count_ways_of_winning(race) == expected;
+                         });
+}
+
+struct Solution {
+  static constexpr int day = 6;
+  static constexpr const char *input_path = "inputs/day06.txt";
+  using Model = std::vector<Race>;
+
+  static Model parse(const std::vector<std::string> &input) {
+    return parse_races(input);
+  }
+  static unsigned long part1(const Model &model) { return day06::part1(model); }
+  static unsigned long part2(const Model &model) { return day06::part2(model); }
+  static void add_benchmarks(BenchSuite &suite) {
+    day06::add_benchmarks(suite);
+  }
+  static void add_checks(CheckSuite &suite) { day06::add_checks(suite); }
+};
+
+} // namespace day06
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv) {
+  return run_day<day06::Solution>(argc, argv);
 }
+#endif
@@ -0,0 +1,263 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+// Live-heap accounting through replacements of the global operator new and
+// delete, including the std::align_val_t overloads. Each block carries a
+// header with its size so unsized delete can account for it. Include in
+// exactly one translation unit per binary. The hooks stay out of line so
+// callers never see the header arithmetic.
+namespace heap_stats {
+std::atomic<std::size_t> live_bytes{0};
+std::atomic<std::size_t> peak_bytes{0};
+// Live-byte limit checked on every allocation, 0 for none.
+std::atomic<std::size_t> limit_bytes{0};
+// What is running, for the report when the limit is crossed.
+int day = 0;
+const char *phase = "";
+} // namespace heap_stats
+
+constexpr std::size_t kAllocationHeader = alignof(std::max_align_t);
+
+// Reports the day and phase and exits. Uses stdio only, since allocating
+// here would re-enter operator new.
+[[noreturn]] void heap_limit_exceeded(std::size_t live, std::size_t limit) {
+  heap_stats::limit_bytes = 0;
+  std::fflush(stdout);
+  std::fprintf(stderr,
+               "Memory budget exceeded: day %d %s: live heap %zu bytes, "
+               "limit %zu bytes\n",
+               heap_stats::day, heap_stats::phase, live, limit);
+  std::fflush(stderr);
+  std::_Exit(1);
+}
+
+void record_allocation(std::size_t size) {
+  const std::size_t live =
+      heap_stats::live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  const std::size_t limit =
+      heap_stats::limit_bytes.load(std::memory_order_relaxed);
+  if (limit != 0 && live > limit) {
+    heap_limit_exceeded(live, limit);
+  }
+  std::size_t peak = heap_stats::peak_bytes.load(std::memory_order_relaxed);
+  while (live > peak && !heap_stats::peak_bytes.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void record_free(std::size_t size) {
+  heap_stats::live_bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+[[gnu::noinline]] void *operator new(std::size_t size) {
+  void *block = std::malloc(size + kAllocationHeader);
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  *static_cast<std::size_t *>(block) = size;
+  record_allocation(size);
+  return static_cast<char *>(block) + kAllocationHeader;
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+[[gnu::noinline]] void operator delete(void *p) noexcept {
+  if (p == nullptr) {
+    return;
+  }
+  void *block = static_cast<char *>(p) - kAllocationHeader;
+  record_free(*static_cast<std::size_t *>(block));
+  std::free(block);
+}
+
+void operator delete[](void *p) noexcept { operator delete(p); }
+void operator delete(void *p, std::size_t) noexcept { operator delete(p); }
+void operator delete[](void *p, std::size_t) noexcept { operator delete(p); }
+
+// Over-aligned blocks use a header of one alignment unit, so the pointer
+// handed out keeps the requested alignment.
+std::size_t aligned_header(std::align_val_t alignment) {
+  return std::max(kAllocationHeader, static_cast<std::size_t>(alignment));
+}
+
+[[gnu::noinline]] void *operator new(std::size_t size,
+                                     std::align_val_t alignment) {
+  const std::size_t header = aligned_header(alignment);
+  const std::size_t align = static_cast<std::size_t>(alignment);
+  // aligned_alloc needs a size that is a multiple of the alignment.
+  const std::size_t total = (size + header + align - 1) / align * align;
+  void *block = std::aligned_alloc(align, total);
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  *static_cast<std::size_t *>(block) = size;
+  record_allocation(size);
+  return static_cast<char *>(block) + header;
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return operator new(size, alignment);
+}
+
+[[gnu::noinline]] void operator delete(void *p,
+                                       std::align_val_t alignment) noexcept {
+  if (p == nullptr) {
+    return;
+  }
+  void *block = static_cast<char *>(p) - aligned_header(alignment);
+  record_free(*static_cast<std::size_t *>(block));
+  std::free(block);
+}
+
+void operator delete[](void *p, std::align_val_t alignment) noexcept {
+  operator delete(p, alignment);
+}
+void operator delete(void *p, std::size_t,
+                     std::align_val_t alignment) noexcept {
+  operator delete(p, alignment);
+}
+void operator delete[](void *p, std::size_t,
+                       std::align_val_t alignment) noexcept {
+  operator delete(p, alignment);
+}
+
+std::size_t heap_live_bytes() { return heap_stats::live_bytes; }
+std::size_t heap_peak_bytes() { return heap_stats::peak_bytes; }
+
+// Starts a new high-water mark at the current live size.
+void reset_heap_peak() { heap_stats::peak_bytes = heap_live_bytes(); }
+
+std::size_t peak_rss_bytes() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  return usage.ru_maxrss * 1024;
+#endif
+}
+
+// Memory report and budgets, set with
+//   --memory                 print peak RSS and per-phase heap high-water marks
+//   --max-heap-mb MB         fail once the live heap exceeds MB
+//   --budget DAY=MB          the same for one day, overriding --max-heap-mb
+//   --max-heap-ratio RATIO   fail once a phase grows the live heap by more
+//                            than RATIO bytes per input byte
+//   --max-rss-mb MB          fail when the process peak RSS exceeds MB
+// Heap budgets are enforced on every allocation, so a runaway phase stops with
+// a report instead of being killed; peak RSS is checked after each day. The
+// ratio includes fixed costs such as stream buffers, so it is only meaningful
+// for inputs well above a few kilobytes. Setting a budget implies --memory.
+// Zero means unlimited.
+struct MemoryBudget {
+  bool report = false;
+  double max_rss_mb = 0;
+  double max_heap_mb = 0;
+  double max_heap_ratio = 0;
+  std::map<int, double> day_heap_mb;
+
+  double heap_mb(int day) const {
+    const auto it = day_heap_mb.find(day);
+    return it == day_heap_mb.end() ? max_heap_mb : it->second;
+  }
+};
+
+// Consumes the memory flag at argv[i], and its value if it takes one. Returns
+// false if argv[i] is not a memory flag.
+bool parse_memory_flag(int argc, char **argv, int &i, MemoryBudget &budget) {
+  const std::string flag = argv[i];
+  if (flag == "--memory") {
+    budget.report = true;
+    return true;
+  }
+  if (flag != "--max-rss-mb" && flag != "--max-heap-mb" &&
+      flag != "--max-heap-ratio" && flag != "--budget") {
+    return false;
+  }
+  if (i + 1 >= argc) {
+    throw std::runtime_error("Missing value for " + flag);
+  }
+  const std::string value = argv[++i];
+  if (flag == "--budget") {
+    const auto separator = value.find('=');
+    if (separator == std::string::npos) {
+      throw std::runtime_error("Expected DAY=MB for --budget, got " + value);
+    }
+    budget.day_heap_mb[std::stoi(value.substr(0, separator))] =
+        std::stod(value.substr(separator + 1));
+  } else if (flag == "--max-rss-mb") {
+    budget.max_rss_mb = std::stod(value);
+  } else if (flag == "--max-heap-mb") {
+    budget.max_heap_mb = std::stod(value);
+  } else {
+    budget.max_heap_ratio = std::stod(value);
+  }
+  budget.report = true;
+  return true;
+}
+
+// Heap high-water mark of one phase of a run, above what was live when the
+// phase started.
+struct PhaseMemory {
+  std::string name;
+  std::size_t peak_bytes;
+};
+
+// Runs one phase of `day` with the heap budgets turned into a live-byte limit
+// for the allocation hook.
+template <typename F>
+auto measure_phase(PhaseMemory &phase, const MemoryBudget &budget, int day,
+                   std::size_t input_bytes, F &&f) {
+  const std::size_t live = heap_live_bytes();
+  std::size_t limit = static_cast<std::size_t>(budget.heap_mb(day) * 1e6);
+  if (budget.max_heap_ratio > 0) {
+    const std::size_t phase_limit =
+        live + static_cast<std::size_t>(budget.max_heap_ratio * input_bytes);
+    limit = limit == 0 ? phase_limit : std::min(limit, phase_limit);
+  }
+  heap_stats::day = day;
+  heap_stats::phase = phase.name.c_str();
+  reset_heap_peak();
+  heap_stats::limit_bytes = limit;
+  auto result = f();
+  heap_stats::limit_bytes = 0;
+  phase.peak_bytes = heap_peak_bytes() - live;
+  return result;
+}
+
+// Prints the report if requested; returns false when the RSS budget is
+// exceeded. Heap budgets were already enforced while the phases ran.
+bool check_memory_budget(std::size_t input_bytes,
+                         const std::vector<PhaseMemory> &phases,
+                         const MemoryBudget &budget) {
+  const double rss_mb = peak_rss_bytes() / 1e6;
+  if (budget.report) {
+    std::cout << "Memory (input " << input_bytes << " bytes):" << std::endl;
+    for (const auto &phase : phases) {
+      std::cout << "  " << phase.name << ": heap peak " << phase.peak_bytes
+                << " bytes, "
+                << static_cast<double>(phase.peak_bytes) /
+                       std::max<std::size_t>(input_bytes, 1)
+                << " bytes/input byte" << std::endl;
+    }
+    std::cout << "  peak RSS " << rss_mb << " MB" << std::endl;
+  }
+  if (budget.max_rss_mb > 0 && rss_mb > budget.max_rss_mb) {
+    std::cerr << "Memory budget exceeded: peak RSS " << rss_mb
+              << " MB, budget " << budget.max_rss_mb << " MB" << std::endl;
+    return false;
+  }
+  return true;
+}
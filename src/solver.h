@@ -0,0 +1,88 @@
+#pragma once
+#include <concepts>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "check.h"
+#include "memory.h"
+#include "util.h"
+
+// A day's solution: parses the puzzle input once into a Model that both parts
+// share. Everything is static so the runner dispatches at compile time.
+template <typename S>
+concept Solver = requires(const std::vector<std::string> &input,
+                          const typename S::Model &model, BenchSuite &bench,
+                          CheckSuite &check) {
+  { S::day } -> std::convertible_to<int>;
+  { S::input_path } -> std::convertible_to<std::string>;
+  { S::parse(input) } -> std::same_as<typename S::Model>;
+  std::cout << S::part1(model);
+  std::cout << S::part2(model);
+  S::add_benchmarks(bench);
+  S::add_checks(check);
+};
+
+// Solves both parts, tracking the heap high-water mark of each phase. Exits
+// when a heap budget is exceeded; returns false when the RSS budget is.
+template <Solver S>
+bool solve(const std::string &path, const MemoryBudget &budget = {}) {
+  const std::size_t input_bytes = std::filesystem::file_size(path);
+  std::vector<PhaseMemory> phases{{"parse"}, {"part1"}, {"part2"}};
+  const auto phase = [&budget, input_bytes](PhaseMemory &memory, auto &&f) {
+    return measure_phase(memory, budget, S::day, input_bytes, f);
+  };
+  const typename S::Model model =
+      phase(phases[0], [&path] { return S::parse(read_input(path)); });
+  const auto result1 = phase(phases[1], [&model] { return S::part1(model); });
+  const auto result2 = phase(phases[2], [&model] { return S::part2(model); });
+  std::cout << "Part 1: " << result1 << std::endl;
+  std::cout << "Part 2: " << result2 << std::endl;
+  return check_memory_budget(input_bytes, phases, budget);
+}
+
+// Exit code for bad flags and other errors reported by exception.
+constexpr int kUsageError = 2;
+
+// Entry point of the single-day binaries:
+//   dayNN [--bench ... | --check ... | memory flags, see MemoryBudget]
+template <Solver S> int run_day(int argc, char **argv) {
+  try {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+      BenchSuite suite;
+      S::add_benchmarks(suite);
+      return suite.main(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--check") {
+      CheckSuite suite;
+      S::add_checks(suite);
+      return suite.main(argc, argv);
+    }
+    MemoryBudget budget;
+    for (int i = 1; i < argc; ++i) {
+      if (!parse_memory_flag(argc, argv, i, budget)) {
+        throw std::runtime_error("Unknown flag " + std::string(argv[i]));
+      }
+    }
+    return solve<S>(S::input_path, budget) ? 0 : 1;
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return kUsageError;
+  }
+}
+
+// Compile-time list of solvers; `f` is called as `f.template operator()<S>()`.
+template <Solver... Days> struct DayRegistry {
+  template <typename F> static void for_each(F &&f) {
+    (f.template operator()<Days>(), ...);
+  }
+
+  // Returns false if no solver is registered for `day`.
+  template <typename F> static bool dispatch(int day, F &&f) {
+    return ((Days::day == day && (f.template operator()<Days>(), true)) || ...);
+  }
+};
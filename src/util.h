@@ -1,8 +1,13 @@
 #pragma once
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <fstream>
 #include <functional>
+#include <iterator>
 #include <map>
+#include <ranges>
+#include <stdexcept>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -45,4 +50,250 @@ std::vector<std::string> read_input(std::string path) {
     lines.push_back(line);
   }
   return lines;
-}
\ No newline at end of file
+}
+
+// Returns the value of the command-line flag at argv[i] and advances i past
+// it; throws if the flag is the last argument.
+std::string flag_value(int argc, char **argv, int &i) {
+  if (i + 1 >= argc) {
+    throw std::runtime_error("Missing value for " + std::string(argv[i]));
+  }
+  return argv[++i];
+}
+
+// Reduces a (possibly lazy) range in a single pass, without materializing it.
+template <std::ranges::input_range R, typename T, typename Op = std::plus<>>
+T fold(R &&range, T init, Op op = {}) {
+  for (auto &&item : range) {
+    init = op(std::move(init), item);
+  }
+  return init;
+}
+
+template <std::ranges::input_range R> auto sum(R &&range) {
+  return fold(std::forward<R>(range), std::ranges::range_value_t<R>{});
+}
+
+template <std::ranges::input_range R> auto min_of(R &&range) {
+  auto it = std::ranges::begin(range);
+  const auto last = std::ranges::end(range);
+  if (it == last) {
+    throw std::runtime_error("min_of on empty range");
+  }
+  std::ranges::range_value_t<R> result = *it;
+  for (++it; it != last; ++it) {
+    result = std::min<std::ranges::range_value_t<R>>(result, *it);
+  }
+  return result;
+}
+
+// splitmix64 finalizer: every input bit affects every output bit, so packed
+// keys and identity std::hash values spread evenly over a power-of-two table.
+std::uint64_t mix_hash(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// Vector that keeps up to N elements inline and only allocates when it grows
+// beyond that.
+template <typename T, std::size_t N> class SmallVector {
+public:
+  void push_back(const T &value) {
+    if (size_ < N) {
+      inline_[size_] = value;
+    } else {
+      if (size_ == N) {
+        heap_.assign(inline_.begin(), inline_.end());
+      }
+      heap_.push_back(value);
+    }
+    ++size_;
+  }
+
+  void clear() {
+    heap_.clear();
+    size_ = 0;
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  T *data() { return size_ <= N ? inline_.data() : heap_.data(); }
+  const T *data() const { return size_ <= N ? inline_.data() : heap_.data(); }
+  T &operator[](std::size_t i) { return data()[i]; }
+  const T &operator[](std::size_t i) const { return data()[i]; }
+
+  T *begin() { return data(); }
+  T *end() { return data() + size_; }
+  const T *begin() const { return data(); }
+  const T *end() const { return data() + size_; }
+
+private:
+  std::array<T, N> inline_{};
+  std::vector<T> heap_;
+  std::size_t size_ = 0;
+};
+
+// Open-addressing hash map with linear probing. Control bytes, keys and values
+// live in separate arrays, so probing only touches the dense control bytes
+// until a tag matches. Hashes are passed through mix_hash, which makes weak
+// hashes such as the identity std::hash<int> safe to use.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class FlatHashMap {
+  static constexpr std::int8_t kEmpty = -128;
+
+  // Dereferences to a pair of references into the key and value arrays. That
+  // pair is also its value_type, so it is a forward iterator in the C++20
+  // sense but not a legacy one.
+  template <bool Const> class Iterator {
+    using Map = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+    using Value = std::conditional_t<Const, const V, V>;
+
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::pair<const K &, Value &>;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+
+    Iterator() = default;
+    Iterator(Map *map, std::size_t index) : map_(map), index_(index) {
+      skip_empty();
+    }
+    reference operator*() const {
+      return {map_->keys_[index_], map_->values_[index_]};
+    }
+    Iterator &operator++() {
+      ++index_;
+      skip_empty();
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+    bool operator==(const Iterator &other) const {
+      return index_ == other.index_;
+    }
+
+  private:
+    void skip_empty() {
+      while (index_ < map_->ctrl_.size() && map_->ctrl_[index_] == kEmpty) {
+        ++index_;
+      }
+    }
+    Map *map_ = nullptr;
+    std::size_t index_ = 0;
+  };
+
+public:
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  // Unlike std::unordered_map, any insertion may rehash and invalidate
+  // references and iterators obtained earlier.
+  V &operator[](const K &key) {
+    const std::uint64_t h = mix_hash(Hash{}(key));
+    if (!ctrl_.empty()) {
+      const auto [index, found] = probe(key, h);
+      if (found) {
+        return values_[index];
+      }
+    }
+    if ((size_ + 1) * 4 > ctrl_.size() * 3) {
+      rehash(std::max<std::size_t>(16, ctrl_.size() * 2));
+    }
+    const std::size_t index = probe(key, h).first;
+    ctrl_[index] = tag(h);
+    keys_[index] = key;
+    values_[index] = V{};
+    ++size_;
+    return values_[index];
+  }
+
+  iterator find(const K &key) {
+    if (size_ == 0) {
+      return end();
+    }
+    const auto [index, found] = probe(key, mix_hash(Hash{}(key)));
+    return found ? iterator(this, index) : end();
+  }
+  const_iterator find(const K &key) const {
+    if (size_ == 0) {
+      return end();
+    }
+    const auto [index, found] = probe(key, mix_hash(Hash{}(key)));
+    return found ? const_iterator(this, index) : end();
+  }
+
+  void reserve(std::size_t count) {
+    std::size_t capacity = 16;
+    while (count * 4 > capacity * 3) {
+      capacity *= 2;
+    }
+    if (capacity > ctrl_.size()) {
+      rehash(capacity);
+    }
+  }
+
+  void clear() {
+    std::fill(ctrl_.begin(), ctrl_.end(), kEmpty);
+    size_ = 0;
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, ctrl_.size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, ctrl_.size()); }
+
+private:
+  static std::int8_t tag(std::uint64_t h) {
+    return static_cast<std::int8_t>(h >> 57);
+  }
+
+  // Returns the slot holding `key`, or the empty slot where it would go.
+  std::pair<std::size_t, bool> probe(const K &key, std::uint64_t h) const {
+    const std::size_t mask = ctrl_.size() - 1;
+    const std::int8_t t = tag(h);
+    for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+      if (ctrl_[i] == kEmpty) {
+        return {i, false};
+      }
+      if (ctrl_[i] == t && keys_[i] == key) {
+        return {i, true};
+      }
+    }
+  }
+
+  void rehash(std::size_t capacity) {
+    std::vector<std::int8_t> old_ctrl(capacity, kEmpty);
+    std::vector<K> old_keys(capacity);
+    std::vector<V> old_values(capacity);
+    old_ctrl.swap(ctrl_);
+    old_keys.swap(keys_);
+    old_values.swap(values_);
+    for (std::size_t i = 0; i < old_ctrl.size(); ++i) {
+      if (old_ctrl[i] == kEmpty) {
+        continue;
+      }
+      const std::uint64_t h = mix_hash(Hash{}(old_keys[i]));
+      const std::size_t index = probe(old_keys[i], h).first;
+      ctrl_[index] = old_ctrl[i];
+      keys_[index] = std::move(old_keys[i]);
+      values_[index] = std::move(old_values[i]);
+    }
+  }
+
+  std::vector<std::int8_t> ctrl_;
+  std::vector<K> keys_;
+  std::vector<V> values_;
+  std::size_t size_ = 0;
+};